@@ -4,14 +4,59 @@
 #define LETTERS 26
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 #include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+#include <atomic>
+#include "WordReader.h"
 using namespace std;
 
+// build with -DTRIE_COUNTERS to count node visits and allocations per operation
+#ifdef TRIE_COUNTERS
+#define TRIE_COUNT(counter, n) ((counter).fetch_add((n), std::memory_order_relaxed))
+#else
+#define TRIE_COUNT(counter, n) ((void)0)
+#endif
+
 
 class Trie {
 
+  public:
+    //
+    // Struct for the shape of a trie, filled in by stats()
+    // leafNodes have no children, terminalNodes end a word (isLeaf).
+    // fanout[i] is how many nodes have i children, depth[i] how many nodes are i letters
+    // below the root (shortest path, for minimal tries)
+    //
+    struct TrieStats {
+      size_t nodes;
+      size_t leafNodes;
+      size_t terminalNodes;
+      vector<size_t> fanout;
+      vector<size_t> depth;
+      size_t bytesUsed;
+      size_t bytesWasted;
+      double averagePathLength;
+    };
+
+    //
+    // Structs for the operation counters (only updated when built with TRIE_COUNTERS)
+    // allocations are nodes created for insert and result strings built for findValidWords
+    //
+    struct OpCounter {
+      atomic<unsigned long long> calls;
+      atomic<unsigned long long> nodeVisits;
+      atomic<unsigned long long> allocations;
+    };
+    struct OpCounters {
+      OpCounter search;
+      OpCounter insert;
+      OpCounter findValidWords;
+    };
+
   protected:
     // private/protected stuff goes here!
     //  - protected allows this class to be inherited
@@ -27,10 +72,12 @@ class Trie {
     // Struct for Trie Nodes
     // Contains array of 'letters' used for paths for words
     // also contains a boolean to check if node is last in a word
+    // and the number of parents pointing at it (more than one only in a minimal trie)
     //
     struct TrieNode {
       TrieNode* children[LETTERS];
       bool isLeaf;
+      int parents;
     };
 
     // keep track of # of words in tree (need for O(1) runtime on wordCount())
@@ -38,7 +85,75 @@ class Trie {
 
     // data member to keep track of root
     TrieNode* root;
+
+    //
+    // Hash and equality functors for the register of minimized nodes
+    // Two nodes are equivalent if they agree on isLeaf and point to the very same children,
+    // which (since children are registered first) means their whole subtrees are equal
+    //
+    struct NodeHash {
+      size_t operator()(const TrieNode* node) const {
+        size_t h = node->isLeaf;
+        for (int i = 0; i < LETTERS; i++) {
+          h = h * 31 + std::hash<const void*>()(node->children[i]);
+        }
+        return h;
+      }
+    };
+    struct NodeEqual {
+      bool operator()(const TrieNode* a, const TrieNode* b) const {
+        return a->isLeaf == b->isLeaf && std::equal(a->children, a->children + LETTERS, b->children);
+      }
+    };
+
+    // build mode: when true the trie is kept as a minimal acyclic automaton (DAWG)
+    // where equal suffix subtrees are shared between many parents
+    bool minimal;
+
+    // register of minimized nodes, only populated while a sorted build is in progress
+    unordered_set<TrieNode*, NodeHash, NodeEqual> registry;
+
+    // nodes along the path of the last word appended that have not been minimized yet
+    // (unchecked[i] is the node reached after i + 1 letters of lastWord)
+    vector<TrieNode*> unchecked;
+
+    // last word appended by appendSorted()
+    string lastWord;
     
+    //
+    // opCounters()
+    // the operation counters, shared by every trie
+    //
+    static OpCounters& opCounters() {
+      static OpCounters counters;
+      return counters;
+    }
+
+    //
+    // countPaths()
+    // number of words in the subtree of node and the total of their lengths measured from
+    // node, memoized per node so shared subtrees of a minimal trie are only counted once
+    //
+    pair<size_t, size_t> countPaths(TrieNode* node, unordered_map<TrieNode*, pair<size_t, size_t> >& memo) const{
+      auto found = memo.find(node);
+      if (found != memo.end()) {
+        return found->second;
+      }
+
+      pair<size_t, size_t> paths(node->isLeaf ? 1 : 0, 0);
+      for (int i = 0; i < LETTERS; i++) {
+        if (node->children[i]) {
+          pair<size_t, size_t> child = countPaths(node->children[i], memo);
+          paths.first += child.first;
+          // every word below the child is one letter longer from here
+          paths.second += child.second + child.first;
+        }
+      }
+
+      memo[node] = paths;
+      return paths;
+    }
+
     //
     // newNode()
     // function creates, initializes, and returns a new TrieNode
@@ -46,6 +161,7 @@ class Trie {
     TrieNode* newNode() {
       TrieNode* newNode = new TrieNode;
       newNode->isLeaf = false;
+      newNode->parents = 1;
       for (int i = 0; i < LETTERS; i++) {
         newNode->children[i] = NULL;
       }
@@ -80,6 +196,291 @@ class Trie {
       }
       delete node;
     }
+
+    //
+    // releaseNode()
+    // drops one parent's reference to a node of a minimal trie, freeing the node (and
+    // releasing its children in turn) once no parent points at it
+    //
+    void releaseNode(TrieNode* node) {
+      if (--node->parents > 0) {
+        return;
+      }
+      for (int i = 0; i < LETTERS; i++) {
+        if (node->children[i]) {
+          releaseNode(node->children[i]);
+        }
+      }
+      delete node;
+    }
+
+    //
+    // freeAll()
+    // frees every node of the trie, including root, for either build mode
+    //
+    void freeAll() {
+      if (minimal) {
+        for (int i = 0; i < LETTERS; i++) {
+          if (root->children[i]) {
+            releaseNode(root->children[i]);
+          }
+        }
+        delete root;
+      } else {
+        freeTrieNode(root);
+      }
+    }
+
+    //
+    // minimizePath()
+    // pops unchecked nodes until only 'length' remain, replacing each popped node with an
+    // equivalent registered node if there is one, or registering it otherwise
+    //
+    void minimizePath(size_t length) {
+      while (unchecked.size() > length) {
+        TrieNode* child = unchecked.back();
+        unchecked.pop_back();
+        TrieNode* parent = unchecked.empty() ? root : unchecked.back();
+        int letter = lastWord[unchecked.size()] - 'a';
+
+        auto found = registry.find(child);
+        if (found != registry.end()) {
+          // an equal subtree already exists, point the parent at it instead. The duplicate
+          // has the same children, which lose it as a parent but keep *found
+          parent->children[letter] = *found;
+          (*found)->parents++;
+          for (int i = 0; i < LETTERS; i++) {
+            if (child->children[i]) {
+              child->children[i]->parents--;
+            }
+          }
+          delete child;
+        } else {
+          registry.insert(child);
+        }
+      }
+    }
+
+    //
+    // appendSorted()
+    // adds a word that is strictly greater than every word added before it (Daciuk's
+    // incremental construction). Only the suffix after the common prefix with the previous
+    // word is created, and the previous word's diverging suffix is minimized first
+    //
+    void appendSorted(string_view word) {
+      size_t prefix = 0;
+      while (prefix < word.length() && prefix < lastWord.length() && word[prefix] == lastWord[prefix]) {
+        prefix++;
+      }
+      minimizePath(prefix);
+
+      TrieNode* cur = prefix == 0 ? root : unchecked[prefix - 1];
+      // the shared prefix comes straight out of unchecked, only the new suffix is walked
+      TRIE_COUNT(opCounters().insert.calls, 1);
+      for (size_t i = prefix; i < word.length(); i++) {
+        TrieNode* child = newNode();
+        TRIE_COUNT(opCounters().insert.allocations, 1);
+        cur->children[word[i] - 'a'] = child;
+        unchecked.push_back(child);
+        cur = child;
+        TRIE_COUNT(opCounters().insert.nodeVisits, 1);
+      }
+
+      cur->isLeaf = true;
+      numWords++;
+      // only the new suffix needs copying
+      lastWord.resize(prefix);
+      lastWord.append(word.substr(prefix));
+    }
+
+    //
+    // finishSorted()
+    // minimizes whatever is left of the last word and drops the register
+    //
+    void finishSorted() {
+      minimizePath(0);
+      registry.clear();
+      lastWord.clear();
+    }
+
+    //
+    // rebuildMinimal()
+    // merges the current words with 'extra' and rebuilds the automaton from the sorted result
+    //
+    void rebuildMinimal(vector<string>& extra) {
+      vector<string>* all = words();
+      all->insert(all->end(), extra.begin(), extra.end());
+      sort(all->begin(), all->end());
+      all->erase(unique(all->begin(), all->end()), all->end());
+
+      clear();
+      for (auto& word : *all) {
+        appendSorted(word);
+      }
+      finishSorted();
+      delete all;
+    }
+
+    //
+    // Struct for the state carried between words while getFromFile() loads a file
+    // previous and path describe the last word added in plain mode (path[i] is the node
+    // reached after i letters), so the next word can start where the two words diverge
+    //
+    struct LoadState {
+      bool streaming;
+      vector<string> leftovers;
+      string previous;
+      vector<TrieNode*> path;
+    };
+
+    //
+    // insertAfter()
+    // plain mode bulk insert: starts from the deepest node shared with the previous word
+    // instead of the root, so sorted input only walks and creates each word's new suffix.
+    // Still correct for unsorted input, it just reuses less
+    //
+    bool insertAfter(string_view word, LoadState& state) {
+      TRIE_COUNT(opCounters().insert.calls, 1);
+
+      size_t prefix = 0;
+      while (prefix < word.length() && prefix < state.previous.length() && word[prefix] == state.previous[prefix]) {
+        prefix++;
+      }
+      state.path.resize(prefix + 1);
+      TrieNode* cur = state.path[prefix];
+
+      for (size_t i = prefix; i < word.length(); i++) {
+        int letter = word[i] - 'a';
+
+        // if path does not exist, make new trie node at index
+        if (!cur->children[letter]) {
+          cur->children[letter] = newNode();
+          TRIE_COUNT(opCounters().insert.allocations, 1);
+        }
+
+        cur = cur->children[letter];
+        TRIE_COUNT(opCounters().insert.nodeVisits, 1);
+        state.path.push_back(cur);
+      }
+      state.previous.resize(prefix);
+      state.previous.append(word.substr(prefix));
+
+      // if last letter is a leaf, word already exists, return false
+      if (cur->isLeaf) {
+        return false;
+      }
+      cur->isLeaf = true;
+      numWords++;
+      return true;
+    }
+
+    //
+    // addLoadedWord()
+    // adds one validated, lowercase word read by getFromFile() in whichever way the build
+    // mode calls for
+    //
+    void addLoadedWord(string_view word, LoadState& state) {
+      if (!minimal) {
+        insertAfter(word, state);
+      } else if (word.empty()) {
+        // a blank line is the empty word, which is marked on root (never shared). It can't be
+        // appended in sorted order, and sending it to leftovers would rebuild the whole load
+        if (!root->isLeaf) {
+          root->isLeaf = true;
+          numWords++;
+        }
+      } else if (state.streaming && word > lastWord) {
+        appendSorted(word);
+      } else {
+        state.leftovers.push_back(string(word));
+      }
+    }
+
+    //
+    // findNode()
+    // returns the node reached by the last letter of word, or NULL if its path doesn't
+    // exist. Visits are counted in counter (the operation doing the walk), or not at all
+    // when counter is NULL
+    //
+    TrieNode* findNode(string_view word, OpCounter* counter) const {
+      TrieNode* cur = root;
+      for (auto c : word) {
+        cur = cur->children[c - 'a'];
+        if (!cur) {
+          return NULL;
+        }
+        if (counter) {
+          TRIE_COUNT(counter->nodeVisits, 1);
+        }
+      }
+      return cur;
+    }
+
+    //
+    // clonePath()
+    // copy-on-write walk for a minimal trie: makes every node along the word's path private
+    // (one parent) so the path can be changed without touching words that share it. Only
+    // shared nodes are copied; a node with a single parent on an already private path is
+    // changed in place. Returns the node reached by the last letter. Visits and copies are
+    // counted in counter, or not at all when counter is NULL
+    //
+    TrieNode* clonePath(string_view word, OpCounter* counter) {
+      TrieNode* cur = root;
+      for (auto c : word) {
+        int letter = c - 'a';
+        TrieNode* next = cur->children[letter];
+
+        if (!next) {
+          next = newNode();
+          if (counter) {
+            TRIE_COUNT(counter->allocations, 1);
+          }
+        } else if (next->parents > 1) {
+          // give cur its own copy, which becomes one more parent of the same children
+          TrieNode* copy = newNode();
+          if (counter) {
+            TRIE_COUNT(counter->allocations, 1);
+          }
+          *copy = *next;
+          copy->parents = 1;
+          for (int i = 0; i < LETTERS; i++) {
+            if (copy->children[i]) {
+              copy->children[i]->parents++;
+            }
+          }
+          next->parents--;
+          next = copy;
+        }
+
+        cur->children[letter] = next;
+        cur = next;
+        if (counter) {
+          TRIE_COUNT(counter->nodeVisits, 1);
+        }
+      }
+      return cur;
+    }
+
+    //
+    // prunePath()
+    // after a word is unmarked in a minimal trie, frees the nodes at the end of its (private)
+    // path that no longer lead to any word
+    //
+    void prunePath(string_view word) {
+      vector<TrieNode*> path(1, root);
+      for (auto c : word) {
+        path.push_back(path.back()->children[c - 'a']);
+      }
+
+      for (size_t i = word.length(); i > 0; i--) {
+        TrieNode* node = path[i];
+        if (node->isLeaf || hasChildren(node)) {
+          break;
+        }
+        path[i - 1]->children[word[i - 1] - 'a'] = NULL;
+        delete node;
+      }
+    }
     
     //
     // buildWordVector()
@@ -104,6 +505,88 @@ class Trie {
         }
       }
     }
+
+    //
+    // findRackWords()
+    // builds a vector of all words that can be spelled from a rack of letters in ascending order.
+    // counts[] holds how many of each letter are left and blanks how many wildcards are left,
+    // so any subtree whose next letter can't be paid for is skipped
+    //
+    void findRackWords(TrieNode* node, char str[], int level, vector<string>*& words, int counts[], int blanks) const{
+
+      // if leaf is found, add end of string character to string and push_back to word vector
+      if (node->isLeaf && level > 0) {
+        str[level] = '\0';
+        words->push_back(str);
+      }
+
+      // look for any paths from current node
+      for (int i = 0; i < LETTERS; i++) {
+
+        if (!node->children[i]) {
+          continue;
+        }
+
+        str[level] = i + 'a';
+        // spend the letter itself if we still have it, otherwise fall back on a blank
+        if (counts[i] > 0) {
+          counts[i]--;
+          findRackWords(node->children[i], str, level + 1, words, counts, blanks);
+          counts[i]++;
+        } else if (blanks > 0) {
+          findRackWords(node->children[i], str, level + 1, words, counts, blanks - 1);
+        }
+      }
+    }
+
+    //
+    // findFuzzyWords()
+    // collects every word within maxDistance edits (Levenshtein) of target.
+    // rows holds one edit distance row of target.length() + 1 entries per level, for levels
+    // 0..maxLevel; the row at 'level' is the one for the prefix in str[0..level), so each child
+    // only fills in the row below it, and a subtree is skipped once no entry of its row is
+    // within maxDistance. allowed[] restricts which letters the walk may use
+    //
+    void findFuzzyWords(TrieNode* node, char str[], int level, int maxLevel, const string& target, int rows[],
+                        int maxDistance, const bool allowed[], vector<pair<int, string> >*& matches) const{
+
+      size_t n = target.length();
+      const int* prevRow = rows + level * (n + 1);
+
+      // if leaf is found and the whole target is within reach, record the word and its distance
+      if (node->isLeaf && level > 0 && prevRow[n] <= maxDistance) {
+        str[level] = '\0';
+        matches->push_back(make_pair(prevRow[n], string(str)));
+      }
+
+      // no row left below this one
+      if (level >= maxLevel) {
+        return;
+      }
+
+      int* row = rows + (level + 1) * (n + 1);
+      for (int i = 0; i < LETTERS; i++) {
+
+        if (!node->children[i] || !allowed[i]) {
+          continue;
+        }
+
+        char character = i + 'a';
+        row[0] = prevRow[0] + 1;
+        int best = row[0];
+        for (size_t j = 1; j <= n; j++) {
+          int substitute = prevRow[j - 1] + (target[j - 1] == character ? 0 : 1);
+          row[j] = min(substitute, min(prevRow[j] + 1, row[j - 1] + 1));
+          best = min(best, row[j]);
+        }
+
+        // every extension of this prefix is at least 'best' edits away
+        if (best <= maxDistance) {
+          str[level] = character;
+          findFuzzyWords(node->children[i], str, level + 1, maxLevel, target, rows, maxDistance, allowed, matches);
+        }
+      }
+    }
   public:
     /**
     * constructor and destructor
@@ -112,10 +595,11 @@ class Trie {
       // your constructor code here!
       root = newNode();
       numWords = 0;
+      minimal = false;
     }
     ~Trie(){
       // your destructor code here.
-      freeTrieNode(root);
+      freeAll();
     }
 
     //
@@ -130,40 +614,34 @@ class Trie {
      * function: getFromFile
      * description:  extract all of the words from the file
      *   specified by the filename given in the parameter.
-     *   Words are separated by whitespace characters and 
-     *   must only contain letters.
+     *   Words are one per line (LF or CRLF line endings),
+     *   must only contain letters and are stored lowercase.
      *
      * return:  indicates success/failure (file not readable...)
      */
     bool getFromFile(string filename){
 
-      string line;
-      bool isValidWord;
-
-      // open file
-      ifstream input_file(filename);
+      WordReader reader;
+      string_view word;
+      LoadState state;
+      // in minimal mode, words that can't be appended in sorted order are merged in afterwards
+      state.streaming = minimal && numWords == 0;
+      state.path.push_back(root);
 
-      // check if file opened successfully, if not - return false
-      if (!input_file.is_open()) {
+      // map file, if it can't be read - return false
+      if (!reader.open(filename)) {
         return false;
       }
 
-      // go through every word in file, line by line
-      while (getline(input_file, line)) {
-        isValidWord = true;
-        line.erase(line.length()-1);
-        // loop through every character in word to check if it only contains letters
-        for (auto c : line) {
-          // if character is not in the alphabet, not a valid word
-          if(!isalpha(c)) {
-            isValidWord = false;
-          }
-        }
+      // the reader skips lines that aren't only letters and hands back lowercase words
+      while (reader.next(word)) {
+        addLoadedWord(word, state);
+      }
 
-        // if word only contains letters, insert into trie
-        if (isValidWord) {
-          std::transform(line.begin(), line.end(), line.begin(), ::tolower);
-          insert(line);
+      if (minimal) {
+        finishSorted();
+        if (!state.leftovers.empty()) {
+          rebuildMinimal(state.leftovers);
         }
       }
 
@@ -179,7 +657,20 @@ class Trie {
      *
      * return:  indicates success/failure
      */
-    bool insert(string word){
+    bool insert(string_view word){
+      TRIE_COUNT(opCounters().insert.calls, 1);
+
+      // a minimal trie shares nodes, so copy the path before changing it
+      if (minimal) {
+        TrieNode* found = findNode(word, &opCounters().insert);
+        if (found && found->isLeaf) {
+          return false;
+        }
+        clonePath(word, &opCounters().insert)->isLeaf = true;
+        numWords++;
+        return true;
+      }
+
       //
       // start with root
       //
@@ -193,10 +684,12 @@ class Trie {
         // if path does not exist, make new trie node at index
         if (!cur->children[letter]) {
           cur->children[letter] = newNode();
+          TRIE_COUNT(opCounters().insert.allocations, 1);
         }
 
         // go to next letter in path
         cur = cur->children[letter];
+        TRIE_COUNT(opCounters().insert.nodeVisits, 1);
       }
 
       // if last letter is a leaf, word already exists, return false
@@ -219,7 +712,8 @@ class Trie {
      *
      * return:  indicates success/failure
      */
-    bool search(string word) const{
+    bool search(string_view word) const{
+      TRIE_COUNT(opCounters().search.calls, 1);
 
       // start with root
       TrieNode* cur = root;
@@ -236,6 +730,7 @@ class Trie {
 
         // go to next letter in path
         cur = cur->children[letter];
+        TRIE_COUNT(opCounters().search.nodeVisits, 1);
       }
 
       // if isLeaf --> TRUE 
@@ -253,7 +748,7 @@ class Trie {
      *
      * return:  indicates success/failure
      */
-    bool remove(string word){
+    bool remove(string_view word){
       if (!hasChildren(root))
         return false;
 
@@ -261,6 +756,19 @@ class Trie {
         return true;
       }
 
+      // a minimal trie shares nodes, so unmark a private copy of the path before pruning it
+      if (minimal) {
+        TrieNode* found = findNode(word, NULL);
+        if (!found || !found->isLeaf) {
+          return false;
+        }
+        // remove has no counters of its own
+        clonePath(word, NULL)->isLeaf = false;
+        prunePath(word);
+        numWords--;
+        return true;
+      }
+
       TrieNode* cur = root;
       int letter;
 
@@ -281,7 +789,7 @@ class Trie {
 
       if (!hasChildren(cur)) {
         delete cur;
-        word.pop_back();
+        word.remove_suffix(1);
         remove(word);
       } else {
         cur->isLeaf = false;
@@ -300,7 +808,12 @@ class Trie {
      */
     bool clear(){
       // deallocate all nodes
-      freeTrieNode(root);
+      freeAll();
+
+      // drop any sorted build in progress
+      unchecked.clear();
+      registry.clear();
+      lastWord.clear();
 
       // create new root node
       root = newNode();
@@ -322,6 +835,125 @@ class Trie {
       return numWords;
     }    
 
+    /*
+     * function: setMinimal
+     * description:  switches the build mode of the trie. In minimal mode the
+     *   trie is built as a minimal acyclic word automaton (DAWG): sorted input
+     *   is added incrementally and common suffix subtrees are shared as the
+     *   load proceeds. Words already stored are rebuilt in the new mode.
+     *
+     * return:  none
+     */
+    void setMinimal(bool on){
+      if (on == minimal) {
+        return;
+      }
+
+      vector<string>* all = words();
+      clear();
+      minimal = on;
+
+      for (auto& word : *all) {
+        if (minimal) {
+          appendSorted(word);
+        } else {
+          insert(word);
+        }
+      }
+      if (minimal) {
+        finishSorted();
+      }
+      delete all;
+    }
+
+    /*
+     * function: stats
+     * description:  walks every node once and reports the shape of the trie:
+     *   node counts, fanout and depth histograms, memory used by nodes and
+     *   the part of it spent on null children[] slots, and the average
+     *   path length (letters per word)
+     *
+     * return:  the statistics
+     */
+    TrieStats stats( ) const{
+      TrieStats result;
+      result.nodes = 0;
+      result.leafNodes = 0;
+      result.terminalNodes = 0;
+      result.fanout.assign(LETTERS + 1, 0);
+      size_t nullSlots = 0;
+
+      // breadth first, so each node is counted once at its shallowest depth
+      unordered_set<TrieNode*> visited;
+      vector<TrieNode*> level(1, root);
+      visited.insert(root);
+      while (!level.empty()) {
+        result.depth.push_back(level.size());
+        vector<TrieNode*> next;
+
+        for (auto node : level) {
+          int children = 0;
+          for (int i = 0; i < LETTERS; i++) {
+            if (node->children[i]) {
+              children++;
+              if (visited.insert(node->children[i]).second) {
+                next.push_back(node->children[i]);
+              }
+            }
+          }
+
+          result.nodes++;
+          result.fanout[children]++;
+          nullSlots += LETTERS - children;
+          if (children == 0) {
+            result.leafNodes++;
+          }
+          if (node->isLeaf) {
+            result.terminalNodes++;
+          }
+        }
+        level.swap(next);
+      }
+
+      result.bytesUsed = result.nodes * sizeof(TrieNode);
+      result.bytesWasted = nullSlots * sizeof(TrieNode*);
+
+      unordered_map<TrieNode*, pair<size_t, size_t> > memo;
+      pair<size_t, size_t> paths = countPaths(root, memo);
+      result.averagePathLength = paths.first ? (double)paths.second / paths.first : 0.0;
+      return result;
+    }
+
+    /*
+     * function: getOpCounters / resetOpCounters
+     * description:  read or zero the per operation counters (calls, node
+     *   visits, allocations) for search, insert and findValidWords. They
+     *   stay at zero unless built with -DTRIE_COUNTERS.
+     *
+     * return:  the counters shared by every trie
+     */
+    static const OpCounters& getOpCounters() {
+      return opCounters();
+    }
+    static void resetOpCounters() {
+      OpCounter* all[] = { &opCounters().search, &opCounters().insert, &opCounters().findValidWords };
+      for (auto counter : all) {
+        counter->calls = 0;
+        counter->nodeVisits = 0;
+        counter->allocations = 0;
+      }
+    }
+
+    /*
+     * function: isMinimal
+     * description:  reports the current build mode
+     *
+     * return:  true if the trie is a minimal automaton
+     */
+    bool isMinimal( ) const{
+      return minimal;
+    }
+
 
     /*
      * function: words
@@ -339,6 +971,84 @@ class Trie {
       return words;
     }
 
+    /*
+     * function: rackWords
+     * description:  build a vector of all words in the dictionary that can be
+     *   formed from a rack of letters, Scrabble style: each letter of the rack
+     *   can be used at most once and each '?' is a blank that stands for any
+     *   letter. The words are to be in sorted ascending order.
+     *
+     * parameter: string rack - the letters available (with multiplicities), '?' for blanks
+     *
+     * return:  a pointer to a vector of strings
+     *
+     */
+    std::vector<string>* rackWords(string rack) const{
+      vector<string>* words = new vector<string>;
+      int counts[LETTERS] = {0};
+      int blanks = 0;
+
+      for (auto c : rack) {
+        if (c == '?') {
+          blanks++;
+        } else if (isalpha(c)) {
+          counts[tolower(c) - 'a']++;
+        }
+      }
+
+      // a word can't be longer than the rack
+      char str[100];
+      if (rack.length() >= sizeof(str)) {
+        return words;
+      }
+
+      findRackWords(root, str, 0, words, counts, blanks);
+      return words;
+    }
+
+    /*
+     * function: fuzzyWords
+     * description:  build a vector of all words in the dictionary within
+     *   maxDistance edits (insertions, deletions, substitutions) of the
+     *   given word, ranked by distance and then in ascending order.
+     *
+     * parameter: string word - the word to match
+     *            int maxDistance - the largest edit distance to accept
+     *            string letters - if not empty, only words made of these letters are considered
+     *
+     * return:  a pointer to a vector of (distance, word) pairs
+     *
+     */
+    std::vector<pair<int, string> >* fuzzyWords(string word, int maxDistance, string letters = "") const{
+      vector<pair<int, string> >* matches = new vector<pair<int, string> >;
+
+      bool allowed[LETTERS];
+      for (int i = 0; i < LETTERS; i++) {
+        allowed[i] = letters.empty();
+      }
+      for (auto c : letters) {
+        if (isalpha(c)) {
+          allowed[tolower(c) - 'a'] = true;
+        }
+      }
+
+      // a word more than maxDistance letters longer than 'word' can't match, and str has
+      // room for 99 letters, so no walk goes deeper than maxLevel
+      char str[100];
+      int maxLevel = min((int)word.length() + max(maxDistance, 0) + 1, (int)sizeof(str) - 1);
+
+      // one row per level, allocated once; the first is the distance from the empty prefix
+      // to each prefix of word
+      vector<int> rows((maxLevel + 1) * (word.length() + 1));
+      for (size_t j = 0; j <= word.length(); j++) {
+        rows[j] = j;
+      }
+
+      findFuzzyWords(root, str, 0, maxLevel, word, rows.data(), maxDistance, allowed, matches);
+      sort(matches->begin(), matches->end());
+      return matches;
+    }
+
 
     
 
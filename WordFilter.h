@@ -0,0 +1,192 @@
+
+#ifndef _MY_WORD_FILTER_H
+#define _MY_WORD_FILTER_H
+#define FILTER_BITS_PER_WORD 12
+#define FILTER_PROBES 6
+// trie levels walked before the filter is worth probing (shallower misses are cheaper in the trie)
+#define FILTER_DEPTH 3
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+
+class WordFilter {
+
+  // Blocked Bloom filter over a set of words.
+  //
+  // Every word hashes to a single 512-bit block (one cache line) and sets FILTER_PROBES
+  // bits inside it, so a lookup touches one block no matter how many probes it makes.
+  // mayContain() never says no to a word that was added, and says yes to a word that
+  // wasn't only rarely (about 0.44% of the time at 12 bits per word).
+
+  protected:
+
+    // 8 x 64 bits = one 512-bit block
+    static const int BLOCK_WORDS = 8;
+
+    // filter bits, BLOCK_WORDS per block
+    vector<uint64_t> bits;
+
+    // number of blocks in bits
+    uint64_t numBlocks;
+
+    //
+    // mix()
+    // 64 x 64 -> 128-bit multiply folded back to 64 bits, which mixes every input bit into
+    // every output bit in a single multiplication
+    //
+    static uint64_t mix(uint64_t a, uint64_t b) {
+      __uint128_t product = (__uint128_t)a * b;
+      return (uint64_t)product ^ (uint64_t)(product >> 64);
+    }
+
+    //
+    // load32() / load64()
+    // unaligned fixed size loads (these compile to single instructions, unlike a memcpy of
+    // a variable length)
+    //
+    static uint64_t load32(const char* p) {
+      uint32_t value;
+      memcpy(&value, p, 4);
+      return value;
+    }
+    static uint64_t load64(const char* p) {
+      uint64_t value;
+      memcpy(&value, p, 8);
+      return value;
+    }
+
+    //
+    // hashWord()
+    // hashes the word 8 letters at a time. The last 1-8 letters are read with two
+    // overlapping fixed size loads (or three single bytes for words under 4 letters),
+    // so short words, which are most of them, cost a couple of loads and one mix()
+    //
+    static uint64_t hashWord(string_view word) {
+      const char* p = word.data();
+      size_t length = word.length();
+      uint64_t h = length * 0x9e3779b97f4a7c15ULL;
+
+      while (length > 8) {
+        h = mix(load64(p) ^ 0xa0761d6478bd642fULL, h ^ 0xe7037ed1a0b428dbULL);
+        p += 8;
+        length -= 8;
+      }
+
+      uint64_t tail;
+      if (length >= 4) {
+        tail = (load32(p) << 32) | load32(p + length - 4);
+      } else if (length > 0) {
+        tail = ((uint64_t)(unsigned char)p[0] << 16) | ((uint64_t)(unsigned char)p[length / 2] << 8)
+             | (unsigned char)p[length - 1];
+      } else {
+        tail = 0;
+      }
+      return mix(tail ^ 0xa0761d6478bd642fULL, h ^ 0xe7037ed1a0b428dbULL);
+    }
+
+    //
+    // probeBits()
+    // bit positions inside a block. The multiply carries the low bits of h upward, so they
+    // don't depend on the high bits that chose the block
+    //
+    static uint64_t probeBits(uint64_t h) {
+      return h * 0x9e3779b97f4a7c15ULL;
+    }
+
+    //
+    // blockFor()
+    // returns the first word of the block for hash h (the high 32 bits scaled to numBlocks,
+    // which avoids a division)
+    //
+    uint64_t* blockFor(uint64_t h) {
+      return &bits[(((h >> 32) * numBlocks) >> 32) * BLOCK_WORDS];
+    }
+    const uint64_t* blockFor(uint64_t h) const {
+      return &bits[(((h >> 32) * numBlocks) >> 32) * BLOCK_WORDS];
+    }
+
+  public:
+    /**
+    * constructor
+    */
+    WordFilter() {
+      numBlocks = 0;
+    }
+
+    /*
+     * function: build
+     * description:  replaces the contents of the filter with the given words,
+     *   sized at FILTER_BITS_PER_WORD bits per word
+     *
+     * return:  none
+     */
+    void build(const vector<string>& words) {
+      numBlocks = (words.size() * FILTER_BITS_PER_WORD + 511) / 512;
+      if (numBlocks == 0) {
+        numBlocks = 1;
+      }
+      bits.assign(numBlocks * BLOCK_WORDS, 0);
+
+      for (auto& word : words) {
+        uint64_t h = hashWord(word);
+        uint64_t* block = blockFor(h);
+        // each probe takes 9 bits as a bit position within the block
+        uint64_t positions = probeBits(h);
+        for (int i = 0; i < FILTER_PROBES; i++) {
+          int bit = (positions >> (9 * i)) & 511;
+          block[bit >> 6] |= 1ULL << (bit & 63);
+        }
+      }
+    }
+
+    /*
+     * function: clear
+     * description:  empties the filter; an empty filter rejects every word
+     *
+     * return:  none
+     */
+    void clear() {
+      bits.clear();
+      numBlocks = 0;
+    }
+
+    /*
+     * function: mayContain
+     * description:  checks whether the word may have been added to the filter
+     *
+     * return:  false if the word was definitely not added, true if it probably was
+     */
+    bool mayContain(string_view word) const {
+      if (numBlocks == 0) {
+        return false;
+      }
+
+      uint64_t h = hashWord(word);
+      const uint64_t* block = blockFor(h);
+      uint64_t positions = probeBits(h);
+
+      // test every probe without branching; an early exit would be mispredicted on misses
+      uint64_t found = 1;
+      for (int i = 0; i < FILTER_PROBES; i++) {
+        int bit = (positions >> (9 * i)) & 511;
+        found &= block[bit >> 6] >> (bit & 63);
+      }
+      return found & 1;
+    }
+
+    /*
+     * function: bytes
+     * description:  memory used by the filter bits
+     *
+     * return:  size in bytes
+     */
+    size_t bytes() const {
+      return bits.size() * sizeof(uint64_t);
+    }
+};
+
+#endif
@@ -0,0 +1,250 @@
+
+#ifndef _MY_WORD_READER_H
+#define _MY_WORD_READER_H
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+
+class WordReader {
+
+  // Reads a word list one line at a time straight out of a memory mapped file.
+  //
+  // Each line is one word. A trailing '\r' is dropped (so LF and CRLF files read the same),
+  // lines that contain anything other than letters are skipped, and words come back
+  // lowercase as string_views. Lines that are already lowercase point into the mapping;
+  // only lines with capitals are copied, into a buffer that the next call reuses.
+  //
+  // With SSE2, 16 bytes are classified at a time: newline, non-letter and capital
+  // positions come out of one load as bitmasks, so finding the end of a line, validating
+  // it and spotting capitals is a single pass.
+
+  protected:
+
+    // the mapping, or NULL when no file is open
+    const char* data;
+    size_t size;
+
+    // start of the next line
+    const char* nextLine;
+
+    // lowercased copy of the current word when the line had capitals
+    string buffer;
+
+    //
+    // Struct for what the scan of one line found
+    //
+    struct LineScan {
+      const char* end;    // the '\n' ending the line, or the end of the file
+      size_t badChars;    // characters that aren't letters (including a trailing '\r')
+      bool hasUpper;      // line contains capital letters
+    };
+
+    //
+    // scanScalar()
+    // one character at a time version of the line scan, continuing from p with the
+    // counts found so far
+    //
+    static void scanScalar(const char* p, const char* end, LineScan& scan) {
+      for (; p < end && *p != '\n'; p++) {
+        unsigned char c = *p;
+        if ((unsigned)(c - 'A') < 26u) {
+          scan.hasUpper = true;
+        } else if ((unsigned)(c - 'a') >= 26u) {
+          scan.badChars++;
+        }
+      }
+      scan.end = p;
+    }
+
+    //
+    // scanLine()
+    // finds the end of the line starting at p and classifies its characters
+    //
+    static LineScan scanLine(const char* p, const char* end) {
+      LineScan scan = { end, 0, false };
+
+#ifdef __SSE2__
+      const __m128i newline = _mm_set1_epi8('\n');
+      const __m128i caseBit = _mm_set1_epi8(0x20);
+      const __m128i lowerA = _mm_set1_epi8('a');
+      const __m128i upperA = _mm_set1_epi8('A');
+      // x - 'a' is a letter when it is below 26 unsigned; flipping the sign bit lets the
+      // signed compare do the unsigned one
+      const __m128i signBit = _mm_set1_epi8((char)0x80);
+      const __m128i limit = _mm_set1_epi8((char)(26 ^ 0x80));
+
+      for (; end - p >= 16; p += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        __m128i folded = _mm_or_si128(chunk, caseBit);
+
+        unsigned newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        unsigned letters = _mm_movemask_epi8(_mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8(folded, lowerA), signBit), limit));
+        unsigned capitals = _mm_movemask_epi8(_mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8(chunk, upperA), signBit), limit));
+
+        // only look at the bytes before the newline, if there is one in this chunk
+        unsigned inLine = newlines ? (newlines & -newlines) - 1 : 0xffff;
+        scan.badChars += __builtin_popcount(~letters & inLine);
+        scan.hasUpper = scan.hasUpper || (capitals & inLine);
+
+        if (newlines) {
+          scan.end = p + __builtin_ctz(newlines);
+          return scan;
+        }
+      }
+#endif
+
+      // fewer than 16 bytes left (or no SSE2)
+      scanScalar(p, end, scan);
+      return scan;
+    }
+
+    //
+    // lowercase()
+    // copies word into buffer with capitals turned into lowercase letters
+    //
+    void lowercase(const char* word, size_t length) {
+      buffer.resize(length);
+      char* out = &buffer[0];
+      size_t i = 0;
+
+#ifdef __SSE2__
+      const __m128i upperA = _mm_set1_epi8('A');
+      const __m128i signBit = _mm_set1_epi8((char)0x80);
+      const __m128i limit = _mm_set1_epi8((char)(26 ^ 0x80));
+      const __m128i caseBit = _mm_set1_epi8(0x20);
+
+      for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(word + i));
+        __m128i capitals = _mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8(chunk, upperA), signBit), limit);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(chunk, _mm_and_si128(capitals, caseBit)));
+      }
+#endif
+
+      for (; i < length; i++) {
+        unsigned char c = word[i];
+        out[i] = ((unsigned)(c - 'A') < 26u) ? c | 0x20 : c;
+      }
+    }
+
+  public:
+    /**
+    * constructor and destructor
+    */
+    WordReader() {
+      data = NULL;
+      size = 0;
+      nextLine = NULL;
+    }
+    ~WordReader() {
+      close();
+    }
+
+    // the mapping can't be shared between readers
+    WordReader(const WordReader&) = delete;
+    WordReader& operator=(const WordReader&) = delete;
+
+    /*
+     * function: open
+     * description:  maps the given file for reading, replacing any file
+     *   that was open before
+     *
+     * return:  indicates success/failure (file not readable...)
+     */
+    bool open(string filename) {
+      close();
+
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+        return false;
+      }
+
+      struct stat info;
+      if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+      }
+
+      // an empty file has nothing to map but is still a valid (empty) word list
+      size = info.st_size;
+      if (size > 0) {
+        void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+          ::close(fd);
+          size = 0;
+          return false;
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        data = (const char*)mapping;
+      } else {
+        data = "";
+      }
+      ::close(fd);
+
+      nextLine = data;
+      return true;
+    }
+
+    /*
+     * function: close
+     * description:  unmaps the current file, if any
+     *
+     * return:  none
+     */
+    void close() {
+      if (data && size > 0) {
+        munmap((void*)data, size);
+      }
+      data = NULL;
+      size = 0;
+      nextLine = NULL;
+    }
+
+    /*
+     * function: next
+     * description:  reads the next valid word: the next line that, without
+     *   its line ending, contains only letters. The view stays valid until
+     *   the next call or until the reader is closed.
+     *
+     * return:  false once there are no more words
+     */
+    bool next(string_view& word) {
+      if (!data) {
+        return false;
+      }
+      const char* end = data + size;
+
+      while (nextLine < end) {
+        const char* start = nextLine;
+        LineScan scan = scanLine(start, end);
+        nextLine = scan.end < end ? scan.end + 1 : end;
+
+        size_t length = scan.end - start;
+        if (length > 0 && start[length - 1] == '\r') {
+          length--;
+          scan.badChars--;
+        }
+        if (scan.badChars > 0) {
+          continue;
+        }
+
+        if (scan.hasUpper) {
+          lowercase(start, length);
+          word = string_view(buffer);
+        } else {
+          word = string_view(start, length);
+        }
+        return true;
+      }
+      return false;
+    }
+};
+
+#endif
@@ -8,6 +8,7 @@
 #include <vector>
 #include <iomanip>
 #include <algorithm>
+#include <map>
 
 using std::cout;
 using std::cin;
@@ -83,6 +84,17 @@ void attemptWord(SBTrie *sbt, string letters){
   // check if word is in the dictionary
   if (!sbt->searchDictionary(letters)) {
     cout << "word is not in the dictionary" << endl;
+
+    // offer the closest words that would have counted
+    vector<pair<int, string> > *suggestions = sbt->suggestWords(letters, 2);
+    if (!suggestions->empty()) {
+      string message = "closest words:";
+      for (size_t i = 0; i < suggestions->size() && i < 5; i++) {
+        message += " " + (*suggestions)[i].second;
+      }
+      cout << message << endl;
+    }
+    delete suggestions;
     return;
   }
 
@@ -133,7 +145,7 @@ void showAllWords(SBTrie *sbt){
   char central;
   string allowed;
   sbt->getLetters(central, allowed);
-  vector<string> *sbWords = sbt->sbWords(central, allowed);
+  vector<string> *sbWords = sbt->sbWordsParallel(central, allowed);
 
   for (auto word : *sbWords) {
     // check if word is a Pangram
@@ -159,8 +171,145 @@ void showAllWords(SBTrie *sbt){
   delete sbWords;
 }
 
+void showHints(SBTrie *sbt){
+  const SBTrie::Hints& hints = sbt->getHints();
+
+  cout << "WORDS: " << hints.words << ", POINTS: " << hints.points << ", PANGRAMS: " << hints.pangrams << endl;
+
+  // every word length that occurs, for the grid columns
+  map<int, int> lengths;
+  for (auto& row : hints.grid) {
+    for (auto& cell : row.second) {
+      lengths[cell.first] += cell.second;
+    }
+  }
+
+  cout << "  ";
+  for (auto& column : lengths) {
+    cout << setw(4) << column.first;
+  }
+  cout << setw(4) << "tot" << endl;
+
+  for (auto& row : hints.grid) {
+    int total = 0;
+    cout << (char)toupper(row.first) << ":";
+    for (auto& column : lengths) {
+      auto cell = row.second.find(column.first);
+      if (cell == row.second.end()) {
+        cout << setw(4) << "-";
+      } else {
+        cout << setw(4) << cell->second;
+        total += cell->second;
+      }
+    }
+    cout << setw(4) << total << endl;
+  }
+
+  cout << "#:";
+  for (auto& column : lengths) {
+    cout << setw(4) << column.second;
+  }
+  cout << setw(4) << hints.words << endl;
+
+  // two letter list
+  char previous = '\0';
+  for (auto& prefix : hints.prefixes) {
+    if (previous != '\0' && prefix.first[0] != previous) {
+      cout << endl;
+    }
+    cout << prefix.first << "-" << prefix.second << " ";
+    previous = prefix.first[0];
+  }
+  cout << endl;
+}
+
+void showHistogram(string title, const vector<size_t>& histogram){
+  cout << title << ":";
+  for (size_t i = 0; i < histogram.size(); i++) {
+    if (histogram[i]) {
+      cout << " " << i << "=" << histogram[i];
+    }
+  }
+  cout << endl;
+}
+
+void showOpCounter(string name, const Trie::OpCounter& counter){
+  cout << setw(16) << name << ": " << counter.calls << " calls, " << counter.nodeVisits << " node visits, "
+       << counter.allocations << " allocations" << endl;
+}
+
+void showStats(SBTrie *sbt){
+  Trie::TrieStats stats = sbt->dictionaryStats();
+
+  cout << "nodes: " << stats.nodes << ", leaf nodes: " << stats.leafNodes << ", terminal nodes: " << stats.terminalNodes << endl;
+  showHistogram("fanout", stats.fanout);
+  showHistogram("depth", stats.depth);
+  cout << "bytes used: " << stats.bytesUsed << ", bytes wasted on null children: " << stats.bytesWasted
+       << " (" << fixed << setprecision(1) << (stats.bytesUsed ? 100.0 * stats.bytesWasted / stats.bytesUsed : 0.0) << "%)" << endl;
+  cout << "average path length: " << setprecision(2) << stats.averagePathLength << endl;
+  cout.unsetf(ios::floatfield);
+  cout << setprecision(6);
+
+#ifdef TRIE_COUNTERS
+  const Trie::OpCounters& counters = Trie::getOpCounters();
+  showOpCounter("search", counters.search);
+  showOpCounter("insert", counters.insert);
+  showOpCounter("findValidWords", counters.findValidWords);
+#else
+  cout << "operation counters disabled (build with -DTRIE_COUNTERS)" << endl;
+#endif
+}
+
+void saveGame(SBTrie *sbt, string filename){
+  vector<SBTrie::Session> sessions(1);
+
+  if (!sbt->saveSession(sessions[0])) {
+    cout << "no puzzle to save, enter letters with 3 first" << endl;
+    return;
+  }
+  if (!SBTrie::saveSessions(filename, sessions)) {
+    cout << "could not save game to " << filename << endl;
+    return;
+  }
+  cout << "game saved to " << filename << endl;
+}
+
+void loadGame(SBTrie *sbt, string filename){
+  vector<SBTrie::Session> sessions;
+
+  if (!SBTrie::loadSessions(filename, sessions) || sessions.empty()) {
+    cout << "could not read a game from " << filename << endl;
+    return;
+  }
+  if (!sbt->restoreSession(sessions[0])) {
+    cout << "saved game does not match the current dictionary" << endl;
+    return;
+  }
+  cout << "game restored from " << filename << endl;
+}
+
+void showRackWords(SBTrie *sbt, string rack){
+  vector<string> *rackWords = sbt->rackWords(rack);
+
+  for (auto word : *rackWords) {
+    cout << word << setw(20 - word.length()) << word.length() << endl;
+  }
+  cout << rackWords->size() << " words" << endl;
+  delete rackWords;
+}
+
+void showAnagrams(SBTrie *sbt, string letters){
+  vector<string> *anagrams = sbt->anagrams(letters);
+
+  for (auto word : *anagrams) {
+    cout << word << endl;
+  }
+  cout << anagrams->size() << " anagrams" << endl;
+  delete anagrams;
+}
+
 void displayCommands(){
-  cout << "\nCommands are given by digits 1 through 9\n\n";
+  cout << "\nCommands are given by digits 1 through 9 and the letters below\n\n";
   cout << "  1 <filename> - read in a new dictionary from a file\n";
   cout << "  2 <filename> - update the existing dictionary with words from a file\n";
   cout << "  3 <7letters> - enter a new central letter and 6 other letters\n";
@@ -169,7 +318,13 @@ void displayCommands(){
   cout << "  6            - display found words and other stats\n";
   cout << "  7            - list all possible Spelling Bee words from the dictionary\n";
   cout << "  8            - display this list of commands\n";
-  cout << "  9            - quit the program\n\n";
+  cout << "  9            - quit the program\n";
+  cout << "  h            - display the hint grid for the current letters\n";
+  cout << "  t            - display dictionary trie statistics\n";
+  cout << "  s <filename> - save the current game to a file\n";
+  cout << "  l <filename> - restore a game saved with s\n";
+  cout << "  r <rack>     - list all words that can be formed from a rack of letters ('?' is a blank)\n";
+  cout << "  a <letters>  - list all exact anagrams of the given letters\n\n";
 
 }
 
@@ -238,6 +393,34 @@ int main(int argc, char** argv){
         showAllWords(sbt);
     }
 
+    if(command == 'h'){
+        showHints(sbt);
+    }
+
+    if(command == 't'){
+        showStats(sbt);
+    }
+
+    if(command == 's'){
+        ss >> input;
+        saveGame(sbt, input);
+    }
+
+    if(command == 'l'){
+        ss >> input;
+        loadGame(sbt, input);
+    }
+
+    if(command == 'r'){
+        ss >> input;
+        showRackWords(sbt, input);
+    }
+
+    if(command == 'a'){
+        ss >> input;
+        showAnagrams(sbt, input);
+    }
+
     if(command == '8' || command == '?'){
         displayCommands();
     }
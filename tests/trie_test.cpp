@@ -0,0 +1,145 @@
+
+#include "../SBTrie.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <iostream>
+
+// live heap allocations, so tests can check that memory stays bounded
+static long liveAllocations = 0;
+
+void* operator new(size_t size) {
+  liveAllocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  if (p) {
+    liveAllocations--;
+    free(p);
+  }
+}
+
+void operator delete(void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+static int failures = 0;
+
+#define CHECK(condition) \
+  do { \
+    if (!(condition)) { \
+      cout << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << endl; \
+      failures++; \
+    } \
+  } while (0)
+
+//
+// minimal mode edits must copy only shared nodes and free what they replace, so repeating
+// the same insert/remove leaves memory where it started
+//
+void testMinimalEditsStayBounded() {
+  Trie trie;
+  trie.setMinimal(true);
+  CHECK(trie.getFromFile("wordlist.txt"));
+
+  vector<string>* before = trie.words();
+  size_t nodesBefore = trie.stats().nodes;
+  long allocationsBefore = liveAllocations;
+
+  for (int i = 0; i < 10000; i++) {
+    CHECK(trie.insert("zzzyzx"));
+    CHECK(trie.remove("zzzyzx"));
+    // also edit a path that is shared with many other words
+    CHECK(trie.remove("nation"));
+    CHECK(trie.insert("nation"));
+  }
+
+  // removing "nation" made private copies of its shared path; nothing else may be left behind
+  CHECK(liveAllocations - allocationsBefore <= 16);
+  CHECK((long)trie.stats().nodes - (long)nodesBefore <= 16);
+
+  vector<string>* after = trie.words();
+  CHECK(*before == *after);
+  CHECK(trie.search("nation"));
+  CHECK(!trie.search("zzzyzx"));
+  delete before;
+  delete after;
+}
+
+//
+// writes raw bytes to a file, for handing loadSessions() files saveSessions() didn't write
+//
+static void writeFile(string filename, string bytes) {
+  ofstream output_file(filename, ios::binary);
+  output_file.write(bytes.data(), bytes.size());
+}
+
+//
+// a saved game restores into another game unchanged, and malformed session files are
+// rejected without touching the sessions already loaded
+//
+void testSessionFiles() {
+  const string filename = "trie_test_sessions.sbs";
+
+  SBTrie game;
+  game.newDictionary("wordlist.txt");
+  game.setRules('a', "elmnpx");
+  game.resetState();
+  int points, score;
+  bool pangram = false, bingo = false;
+  game.wordFound("example", points, score, pangram, bingo);
+  game.wordFound("ample", points, score, pangram, bingo);
+
+  vector<SBTrie::Session> saved(1);
+  CHECK(game.saveSession(saved[0]));
+  CHECK(SBTrie::saveSessions(filename, saved));
+
+  vector<SBTrie::Session> loaded;
+  CHECK(SBTrie::loadSessions(filename, loaded));
+  CHECK(loaded.size() == 1);
+
+  SBTrie restored;
+  restored.newDictionary("wordlist.txt");
+  CHECK(restored.restoreSession(loaded[0]));
+  CHECK(restored.searchFoundWords("example"));
+  CHECK(restored.searchFoundWords("ample"));
+  CHECK(!restored.searchFoundWords("maple"));
+
+  SBTrie::Session again;
+  CHECK(restored.saveSession(again));
+  CHECK(again.score == saved[0].score);
+  CHECK(again.found == saved[0].found);
+  CHECK(again.pangramFound == saved[0].pangramFound);
+
+  // cut off partway through the session
+  ifstream input_file(filename, ios::binary);
+  string bytes((istreambuf_iterator<char>(input_file)), istreambuf_iterator<char>());
+  input_file.close();
+  writeFile(filename, bytes.substr(0, bytes.size() - 3));
+  CHECK(!SBTrie::loadSessions(filename, loaded));
+
+  // a count far larger than the file could hold
+  writeFile(filename, string("SBS1\xff\xff\xff\x7f", 8));
+  CHECK(!SBTrie::loadSessions(filename, loaded));
+  CHECK(loaded.size() == 1);
+
+  remove(filename.c_str());
+}
+
+int main() {
+  testMinimalEditsStayBounded();
+  testSessionFiles();
+
+  if (failures) {
+    cout << failures << " checks failed" << endl;
+    return 1;
+  }
+  cout << "all tests passed" << endl;
+  return 0;
+}